@@ -1,75 +1,1998 @@
+/* POSIX clocks, sockets and lstat() under strict ISO C */
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/* Report granularities for option 6 */
+#define REPORT_YEARLY 1
+#define REPORT_MONTHLY 2
+#define REPORT_PER_PERIOD 3
+
+/* Report output formats for option 6 */
+#define REPORT_SCREEN 1
+#define REPORT_CSV 2
+#define REPORT_BINARY 3
+
+/* Number of incremental steps before the balance is recomputed exactly */
+#define REPORT_REANCHOR_STEPS 64
+
+/* Size of the stdio buffer used when streaming a report to a file */
+#define REPORT_BUFFER_SIZE (1 << 20)
+
+/* Parameters of a report generated by option 6 */
+typedef struct {
+    double P;          // Principal invested at year 0
+    double r;          // Interest rate (in decimal)
+    int n;             // Compounding frequency per year
+    int t1;            // First year included in the report
+    int t2;            // Last year included in the report
+    int granularity;   // REPORT_YEARLY, REPORT_MONTHLY or REPORT_PER_PERIOD
+    double deposit;    // Amount added at the end of every step (negative for withdrawal)
+    long account;      // Index of the account in a batch, or -1 for a single report
+} ReportSpec;
+
+/* Record written for every step of a binary report */
+typedef struct {
+    int account;       // Index of the account in a batch, or -1 for a single report
+    int year;          // Whole years elapsed
+    int step;          // Step within the year (0 for the first step of the year)
+    double balance;    // Balance at the end of the step
+} ReportRecord;
+
+/* Interest rate models for option 8 */
+#define MODEL_VASICEK 1
+#define MODEL_CIR 2
+#define MODEL_BOOTSTRAP 3
+
+/* Most threads runWorkers() starts, including the calling thread */
+#define WORKER_MAX_THREADS 256
+
+/* Paths claimed by a simulation thread at a time */
+#define SIM_CHUNK_PATHS 4096
+
+/* Paths advanced together in the inner loops. Enough lanes that GCC keeps the
+   loops (instead of fully unrolling them) and vectorizes them at -O3 */
+#define SIM_LANES 64
+
+/* Limits for the simulation inputs */
+#define SIM_MAX_THREADS WORKER_MAX_THREADS
+#define SIM_MAX_HISTORY 4096
+
+/* Shared state of a Monte Carlo simulation run by option 8 */
+typedef struct {
+    int model;                 // MODEL_VASICEK, MODEL_CIR or MODEL_BOOTSTRAP
+    double P;                  // Principal invested
+    double r0;                 // Interest rate at time 0 (in decimal)
+    int n;                     // Compounding frequency per year
+    long steps;                // Number of compounding periods simulated
+    double target;             // Balance whose first-passage time is recorded
+    double a;                  // Speed of mean reversion (Vasicek, CIR)
+    double b;                  // Long-term mean rate (Vasicek, CIR)
+    double sigma;              // Rate volatility (Vasicek, CIR)
+    const double* history;     // Historical annual rates (bootstrap)
+    int historyCount;          // Number of historical rates
+    uint64_t seed;             // Key of the counter-based random streams
+    long paths;                // Number of simulated paths
+    double* finals;            // Final balance of every path
+    double* times;             // Years to reach the target, or -1 if never reached
+    atomic_long nextChunk;     // Next chunk of SIM_CHUNK_PATHS paths to simulate
+} Simulation;
+
+/* Scale at which the interest rate is read in option 9 (12 decimal places) */
+#define RATE_SCALE 1000000000000ULL
+
+/* Largest interest rate, principal and balance (in cents) and number of periods
+   accepted by option 9. They keep every product of the exact arithmetic within 128 bits. */
+#define FIXED_MAX_RATE 1e9
+#define FIXED_MAX_CENTS 9007199254740992.0
+#define FIXED_MAX_PERIODS 1e12
+
+/* Periods above which option 9 skips the period-by-period ledger */
+#define LEDGER_MAX_PERIODS 100000
+
+/* Unsigned 128-bit integer used for exact money arithmetic */
+typedef unsigned __int128 uint128;
+
+/* Binary floating-point number with a 128-bit mantissa: mantissa * 2^exponent,
+   with the mantissa normalized to [2^127, 2^128) */
+typedef struct {
+    uint128 mantissa;          // Significant bits, the top one set
+    long exponent;             // Power of two applied to the mantissa
+} WideNumber;
+
+/* Limits of the query daemon */
+#define DAEMON_MAX_CLIENTS 64
+#define DAEMON_BUFFER_SIZE 65536
+#define DAEMON_LATENCY_SAMPLES 65536
+
+/* First byte of a binary daemon request; text requests always start with a letter */
+#define DAEMON_BINARY_MAGIC 0xB5
+
+/* Binary daemon request: op is 'B', 'P', 'R', 'N' or 'T', args as in the text protocol */
+typedef struct {
+    unsigned char magic;       // DAEMON_BINARY_MAGIC
+    unsigned char op;          // Operation to perform
+    unsigned char padding[6];  // Unused, keeps args aligned
+    double args[4];            // Operation arguments
+} DaemonRequest;
+
+/* Binary daemon response */
+typedef struct {
+    int status;                // 0 on success, -1 for an invalid request
+    int padding;               // Unused, keeps value aligned
+    double value;              // Result of the operation
+} DaemonResponse;
+
+/* Connection state of a daemon client */
+typedef struct {
+    int fd;                            // Socket, or -1 if the slot is free
+    size_t inLength;                   // Bytes waiting in in
+    size_t outLength;                  // Bytes waiting in out
+    long pending;                      // Requests answered in out, not yet fully sent
+    struct timespec woke;              // Poll wakeup at which the pending requests were answered
+    char in[DAEMON_BUFFER_SIZE];       // Received, not yet processed requests
+    char out[DAEMON_BUFFER_SIZE];      // Responses not yet sent
+} DaemonClient;
+
+/* Limits of the XIRR solver used by option 10 */
+#define XIRR_MAX_ITERATIONS 100
+#define XIRR_TOLERANCE 1e-12
+#define XIRR_LOWER_BOUND -0.999999
+#define XIRR_UPPER_BOUND 100.0
+#define XIRR_CHUNK_ACCOUNTS 256
+#define XIRR_MAX_THREADS WORKER_MAX_THREADS
+#define XIRR_ID_LENGTH 32
+
+/* Dated cash flows of many accounts, stored flow by flow in parallel arrays */
+typedef struct {
+    long accountCount;                 // Number of accounts
+    long flowCount;                    // Number of cash flows over all accounts
+    char (*ids)[XIRR_ID_LENGTH];       // Identifier of every account
+    long* firstFlow;                   // Index of each account's first flow; firstFlow[accountCount] == flowCount
+    double* years;                     // Years between each flow and its account's first flow
+    double* amounts;                   // Amount of each flow (negative = deposit, positive = withdrawal or balance)
+    double* rates;                     // Annual effective rate of every account, NAN if none was found
+    int* iterations;                   // Iterations used for every account
+    atomic_long nextChunk;             // Next chunk of XIRR_CHUNK_ACCOUNTS accounts to solve
+} CashFlowBook;
+
+/* Settings of the benchmark run by --bench */
+#define BENCH_SAMPLES 65536
+#define BENCH_ROUNDS 11
+#define BENCH_ROUND_SECONDS 0.05
+#define BENCH_DISTINCT_RATES 200
+#define BENCH_VARIANTS 3
+
+/* Slowdown against the baseline that counts as a regression. Even medians of
+   interleaved rounds move by up to about 20% between runs on a shared machine. */
+#define BENCH_REGRESSION_TOLERANCE 0.25
+
+/* Realistic inputs shared by every benchmarked kernel */
+typedef struct {
+    double P[BENCH_SAMPLES];   // Principal invested
+    double r[BENCH_SAMPLES];   // Interest rate (in decimal)
+    double n[BENCH_SAMPLES];   // Compounding frequency per year, as a double so simd loops need no conversion
+    double t[BENCH_SAMPLES];   // Years of investment
+    double B[BENCH_SAMPLES];   // Balance reached after t years
+} BenchData;
+
+/* Kernel evaluated one input at a time */
+typedef double (*ScalarKernel)(const BenchData* data, long i);
+
+/* Kernel evaluated over the whole input arrays */
+typedef void (*BatchKernel)(const BenchData* data, double* out);
+
+/* High-precision reference value of a kernel */
+typedef long double (*ReferenceKernel)(const BenchData* data, long i);
+
+/* A formula benchmarked in its scalar, batched and SIMD variants */
+typedef struct {
+    const char* name;          // Name used in the report and the baseline file
+    ScalarKernel scalar;       // One evaluation per call
+    BatchKernel batched;       // Loop over the inputs using libm, or NULL
+    BatchKernel simd;          // Branch-free loop the compiler can vectorize, or NULL
+    ReferenceKernel reference; // Long double reference
+    ReferenceKernel rounded;   // Long double reference from the double-rounded 1 + r/n, n t and B/P the variants use
+} BenchKernel;
+
+/* Measured throughput and accuracy of one kernel variant */
+typedef struct {
+    double mops;               // Millions of evaluations per second
+    double maxUlp;             // Largest error against the reference, in units in the last place
+    double meanUlp;            // Mean error against the reference, in units in the last place
+    double roundedUlp;         // Largest error against the reference from rounded inputs, in units in the last place
+} BenchResult;
+
+/* Function declarations */
+int menu();
+int continueOrExit();
+double getValidInput(const char* prompt);
+double getValidSignedInput(const char* prompt);
+int getValidIntInput(const char* prompt);
+int getValidChoice(const char* prompt, int low, int high);
+int reportStepsPerYear(const ReportSpec* spec);
+double reportExactBalance(const ReportSpec* spec, double stepFactor, double logStep, long k);
+long reportEmptyStep(const ReportSpec* spec, double stepFactor, double logStep, long last);
+long generateReport(const ReportSpec* spec, FILE* out, int format);
+int runReportBatch(const char* formatName, const char* specFile, const char* outFile);
+char* appendLong(char* p, long value);
+void writeCsvRow(FILE* out, long account, int year, int step, double balance);
+uint64_t mix64(uint64_t x);
+void simulationNormals(const uint64_t* keys, uint64_t counter, double* zCos, double* zSin);
+void* simulationWorker(void* arg);
+int runWorkers(void* (*worker)(void*), void* arg, int threads);
+int runSimulation(Simulation* sim, int threads);
+int compareDoubles(const void* a, const void* b);
+double percentile(const double* sorted, long count, double q);
+int loadRateHistory(const char* filename, double* rates, int maxRates);
+uint128 divideHalfEven(uint128 x, uint128 d);
+double findBalance(double P, double r, int n, double t);
+double findPrincipal(double r, int n, double t, double B);
+double findRate(int n, double t, double P, double B);
+int findFrequency(double t, double r, double P, double B);
+double findTime(int n, double r, double P, double B);
+int evaluateQuery(char op, const double args[4], double* value);
+double elapsedMicroseconds(const struct timespec* begin);
+void recordLatency(double microseconds, long requests);
+void latencyPercentiles(double* p50, double* p99, long* count);
+void processClient(DaemonClient* client);
+void stopDaemon(int signal);
+int runDaemon(const char* path);
+long daysFromCivil(int year, int month, int day);
+int isValidDate(int year, int month, int day);
+int compareIds(const void* a, const void* b);
+int loadCashFlows(const char* filename, CashFlowBook* book);
+void freeCashFlows(CashFlowBook* book);
+void presentValue(const double* years, const double* amounts, long count, double rate, double* value, double* derivative);
+double solveXirr(const double* years, const double* amounts, long count, int* iterations);
+void* xirrWorker(void* arg);
+void fillBenchData(BenchData* data);
+double ulpError(double value, long double reference);
+double secondsSince(const struct timespec* begin);
+double measureRound(const BenchKernel* kernel, int variant, const BenchData* data, double* out);
+BenchResult measureKernel(const BenchKernel* kernel, int variant, const BenchData* data, double* out, double* roundMops);
+int runBenchmark(const char* baselineFile);
+void multiplyWide(uint128 a, uint128 b, uint128* high, uint128* low);
+WideNumber wideRatio(uint128 numerator, uint128 denominator);
+WideNumber wideMultiply(WideNumber a, WideNumber b);
+int widePower(WideNumber g, long k, WideNumber* result);
+int wideCents(uint128 cents, WideNumber growth, uint128* result);
+void growthRatio(double r, int n, uint128* numerator, uint128* denominator);
+int exactCentsBalance(uint128 cents, uint128 numerator, uint128 denominator, long k, uint128* result);
+int ledgerCentsBalance(uint128 cents, uint128 numerator, uint128 denominator, long k, uint128* result);
+
+/* Latencies of the most recent daemon requests, in microseconds */
+double daemonLatencies[DAEMON_LATENCY_SAMPLES];
+long daemonRequestCount;
+
+/* Set by SIGINT or SIGTERM to stop the daemon */
+volatile sig_atomic_t daemonStopping;
+
+/* Main function */
+int main(int argc, char* argv[])
+{
+    if (argc == 3 && strcmp(argv[1], "--daemon") == 0) {
+        return runDaemon(argv[2]);
+    } else if (argc == 5 && strcmp(argv[1], "--report") == 0) {
+        return runReportBatch(argv[2], argv[3], argv[4]);
+    } else if ((argc == 2 || argc == 3) && strcmp(argv[1], "--bench") == 0) {
+        return runBenchmark(argc == 3 ? argv[2] : NULL);
+    } else if (argc != 1) {
+        printf("Usage: %s [--daemon socket_path | --report csv|binary spec_file output_file | --bench [baseline_file]]\n", argv[0]);
+        return 1;
+    }
+
+    while (menu()) {
+        printf("\nReturning to menu...\n");
+    }
+    return 0;
+}
+
+/* Function to validate double input */
+double getValidInput(const char* prompt) {
+    double value;
+    printf("%s", prompt);
+    while (scanf("%lf", &value) != 1 || value <= 0) {
+        printf("Invalid input. Please enter a valid positive number.\n");
+        while (getchar() != '\n');
+    }
+    return value;
+}
+
+/* Function to read a double that may be zero or negative */
+double getValidSignedInput(const char* prompt) {
+    double value;
+    printf("%s", prompt);
+    while (scanf("%lf", &value) != 1) {
+        printf("Invalid input. Please enter a valid number.\n");
+        while (getchar() != '\n');
+    }
+    return value;
+}
+
+/* Function to validate an integer choice in the range [low, high] */
+int getValidChoice(const char* prompt, int low, int high) {
+    int value;
+    while (1) {
+        value = getValidIntInput(prompt);
+        if (value >= low && value <= high) {
+            return value;
+        }
+        printf("Invalid input. Please enter an integer between %d and %d.\n", low, high);
+    }
+}
+
+/* Function to validate integer input */
+int getValidIntInput(const char* prompt) {
+    int value;
+    char ch1;
+
+    printf("%s", prompt);
+    while (1) {
+        if (scanf("%d", &value) != 1 || value <= 0) {
+            printf("Invalid input. Please enter a valid positive integer.\n");
+            while (getchar() != '\n');
+        } else {
+            if (scanf("%c", &ch1) == 1 && ch1 != '\n') {
+                printf("Invalid input. Please enter a valid positive integer.\n");
+                while (getchar() != '\n');
+            } else {
+                break;
+            }
+        }
+    }
+    return value;
+}
+
+/* Number of report steps in one year for the given granularity */
+int reportStepsPerYear(const ReportSpec* spec) {
+    if (spec->granularity == REPORT_MONTHLY) {
+        return 12;
+    } else if (spec->granularity == REPORT_PER_PERIOD) {
+        return spec->n;
+    }
+    return 1;
+}
+
+/* Closed-form balance after k steps: P*s^k plus the deposits grown to step k */
+double reportExactBalance(const ReportSpec* spec, double stepFactor, double logStep, long k) {
+    double growth = exp(k * logStep);
+    if (stepFactor == 1.0) {
+        return spec->P + spec->deposit * k;
+    }
+    return spec->P * growth + spec->deposit * (growth - 1) / (stepFactor - 1);
+}
+
+/* First step at which withdrawals have used up the balance, or -1 if that does not
+   happen by step last. With c = deposit / (s - 1) the balance is (P + c) s^k - c,
+   which reaches zero at k = log(c / (P + c)) / log(s). */
+long reportEmptyStep(const ReportSpec* spec, double stepFactor, double logStep, long last) {
+    double steps;
+    long k;
+
+    if (spec->deposit >= 0) {
+        return -1;
+    }
+    if (stepFactor == 1.0) {
+        steps = spec->P / -spec->deposit;
+    } else {
+        double c = spec->deposit / (stepFactor - 1);
+        double ratio = c / (spec->P + c);
+        if (!(ratio > 0)) {
+            return -1;
+        }
+        steps = log(ratio) / logStep;
+    }
+    if (!(steps < last + 1.0)) {
+        return -1;
+    }
+    k = steps > 0 ? (long)ceil(steps) : 0;
+
+    /* Settle the rounding of the logarithm on the closed form itself */
+    while (k > 0 && reportExactBalance(spec, stepFactor, logStep, k - 1) <= 0) {
+        k--;
+    }
+    while (k <= last && reportExactBalance(spec, stepFactor, logStep, k) > 0) {
+        k++;
+    }
+    return k <= last ? k : -1;
+}
+
+/* Write value in decimal at p and return the position after the last digit */
+char* appendLong(char* p, long value) {
+    char digits[24];
+    int count = 0;
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+
+    if (value < 0) {
+        *p++ = '-';
+    }
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (count > 0) {
+        *p++ = digits[--count];
+    }
+    return p;
+}
+
+/* Write one CSV report row, without the account column when account is -1.
+   Formatting with integer arithmetic keeps large CSV reports I/O-bound;
+   fprintf is only used for balances too large to hold in cents. */
+void writeCsvRow(FILE* out, long account, int year, int step, double balance) {
+    char row[96];
+    char* p = row;
+    long cents;
+
+    if (!(fabs(balance) < 1e15)) {
+        if (account >= 0) {
+            fprintf(out, "%ld,", account);
+        }
+        fprintf(out, "%d,%d,%.2f\n", year, step, balance);
+        return;
+    }
+    cents = lround(balance * 100);
+    if (account >= 0) {
+        p = appendLong(p, account);
+        *p++ = ',';
+    }
+    p = appendLong(p, year);
+    *p++ = ',';
+    p = appendLong(p, step);
+    *p++ = ',';
+    if (cents < 0) {
+        *p++ = '-';
+        cents = -cents;
+    }
+    p = appendLong(p, cents / 100);
+    *p++ = '.';
+    *p++ = (char)('0' + cents % 100 / 10);
+    *p++ = (char)('0' + cents % 10);
+    *p++ = '\n';
+    fwrite(row, 1, p - row, out);
+}
+
+/* Stream the balance of every step between t1 and t2 to out.
+   A single report (account -1) starts with a header; batch rows carry the account index instead.
+   Each balance is obtained from the previous one with one multiply and one add;
+   every REPORT_REANCHOR_STEPS steps the closed form is evaluated instead so the
+   rounding error of the recurrence cannot accumulate over long schedules.
+   If withdrawals use up the balance, that step shows 0.00 and the schedule ends there.
+   Returns the number of rows written, or -1 on a write error. */
+long generateReport(const ReportSpec* spec, FILE* out, int format) {
+    int stepsPerYear = reportStepsPerYear(spec);
+    double logStep = log1p(spec->r / spec->n) * spec->n / stepsPerYear;
+    double stepFactor = exp(logStep);
+    long first = (long)spec->t1 * stepsPerYear;
+    long last = (long)spec->t2 * stepsPerYear;
+    long empty = reportEmptyStep(spec, stepFactor, logStep, last);
+    long rows = 0;
+    double B = reportExactBalance(spec, stepFactor, logStep, first);
+
+    if (empty >= 0) {
+        last = empty;
+    }
+
+    if (format == REPORT_SCREEN) {
+        if (spec->granularity == REPORT_YEARLY) {
+            fprintf(out, "%-6s %-15s %-15s %-20s %-12s\n", "Year", "Principal", "Interest rate", "Compound ratio", "Balance");
+        } else {
+            fprintf(out, "%-6s %-6s %-15s %-15s %-20s %-12s\n", "Year", "Step", "Principal", "Interest rate", "Compound ratio", "Balance");
+        }
+    } else if (format == REPORT_CSV && spec->account < 0) {
+        fprintf(out, "year,step,balance\n");
+    }
+
+    for (long k = first; k <= last; k++) {
+        int year = (int)(k / stepsPerYear);
+        int step = (int)(k % stepsPerYear);
+
+        if (k != first) {
+            if ((k - first) % REPORT_REANCHOR_STEPS == 0) {
+                B = reportExactBalance(spec, stepFactor, logStep, k);
+            } else {
+                B = B * stepFactor + spec->deposit;
+            }
+        }
+        if (k == empty) {
+            B = 0;
+        }
+
+        if (format == REPORT_SCREEN) {
+            /* Principal is the amount invested so far: P plus the net deposits */
+            double principal = spec->P + spec->deposit * k;
+            if (spec->granularity == REPORT_YEARLY) {
+                fprintf(out, "%-6d %-15.2f %-15.3f %-20d %-12.2f\n", year, principal, spec->r, spec->n, B);
+            } else {
+                fprintf(out, "%-6d %-6d %-15.2f %-15.3f %-20d %-12.2f\n", year, step, principal, spec->r, spec->n, B);
+            }
+        } else if (format == REPORT_CSV) {
+            writeCsvRow(out, spec->account, year, step, B);
+        } else {
+            ReportRecord record;
+            record.account = (int)spec->account;
+            record.year = year;
+            record.step = step;
+            record.balance = B;
+            fwrite(&record, sizeof(record), 1, out);
+        }
+        rows++;
+    }
+    if (empty >= 0 && format == REPORT_SCREEN) {
+        fprintf(out, "The withdrawals use up the balance in year %ld; the schedule stops there.\n", empty / stepsPerYear);
+    }
+
+    if (ferror(out)) {
+        return -1;
+    }
+    return rows;
+}
+
+/* Generate the reports of every account in specFile into one buffered output file.
+   Each line of specFile is "P r n t1 t2 granularity deposit"; accounts are numbered
+   from 0 in file order. Returns 0 on success, or 1 on an error. */
+int runReportBatch(const char* formatName, const char* specFile, const char* outFile) {
+    FILE* in;
+    FILE* out;
+    char* buffer;
+    char line[256];
+    ReportSpec spec;
+    long lineNumber = 0, rows = 0;
+    int format, failed = 0;
+
+    if (strcmp(formatName, "csv") == 0) {
+        format = REPORT_CSV;
+    } else if (strcmp(formatName, "binary") == 0) {
+        format = REPORT_BINARY;
+    } else {
+        printf("Unknown report format %s; use csv or binary.\n", formatName);
+        return 1;
+    }
+    in = fopen(specFile, "r");
+    if (in == NULL) {
+        printf("Could not read report specifications from %s.\n", specFile);
+        return 1;
+    }
+    out = fopen(outFile, format == REPORT_CSV ? "w" : "wb");
+    if (out == NULL) {
+        printf("Could not open %s for writing.\n", outFile);
+        fclose(in);
+        return 1;
+    }
+    buffer = malloc(REPORT_BUFFER_SIZE);
+    if (buffer != NULL) {
+        setvbuf(out, buffer, _IOFBF, REPORT_BUFFER_SIZE);
+    }
+    if (format == REPORT_CSV) {
+        fprintf(out, "account,year,step,balance\n");
+    }
+
+    spec.account = 0;
+    while (!failed && fgets(line, sizeof(line), in) != NULL) {
+        lineNumber++;
+        if (sscanf(line, "%lf %lf %d %d %d %d %lf", &spec.P, &spec.r, &spec.n, &spec.t1, &spec.t2,
+                   &spec.granularity, &spec.deposit) != 7 ||
+            !(spec.P > 0) || !(spec.r > 0) || spec.n <= 0 || spec.t1 < 0 || spec.t2 < spec.t1 ||
+            spec.granularity < REPORT_YEARLY || spec.granularity > REPORT_PER_PERIOD) {
+            printf("Skipping invalid line %ld.\n", lineNumber);
+            continue;
+        }
+        long written = generateReport(&spec, out, format);
+        if (written < 0) {
+            failed = 1;
+        } else {
+            rows += written;
+            spec.account++;
+        }
+    }
+    fclose(in);
+
+    if (fclose(out) != 0 || failed) {
+        printf("An error occurred while writing %s.\n", outFile);
+        free(buffer);
+        return 1;
+    }
+    free(buffer);
+    printf("%ld rows for %ld accounts written to %s.\n", rows, spec.account, outFile);
+    return 0;
+}
+
+/* SplitMix64 finalizer: a bijective 64-bit mixing function */
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/* exp(x) for |x| < 700 without branches or table lookups, so loops calling it vectorize.
+   x = k*ln2 + f with |f| <= ln2/2, and exp(f) is a degree-13 Taylor polynomial.
+   k is rounded by adding 1.5*2^52, which leaves it in the low mantissa bits. */
+static inline double simdExp(double x) {
+    double shifted = x * 1.4426950408889634 + 6755399441055744.0;
+    double k = shifted - 6755399441055744.0;
+    double f = x - k * 6.93147180369123816490e-01 - k * 1.90821492927058770002e-10;
+    double p = 1.0 / 6227020800.0;
+    uint64_t bits;
+    double scale;
+
+    p = p * f + 1.0 / 479001600.0;
+    p = p * f + 1.0 / 39916800.0;
+    p = p * f + 1.0 / 3628800.0;
+    p = p * f + 1.0 / 362880.0;
+    p = p * f + 1.0 / 40320.0;
+    p = p * f + 1.0 / 5040.0;
+    p = p * f + 1.0 / 720.0;
+    p = p * f + 1.0 / 120.0;
+    p = p * f + 1.0 / 24.0;
+    p = p * f + 1.0 / 6.0;
+    p = p * f + 0.5;
+    p = p * f + 1.0;
+    p = p * f + 1.0;
+    memcpy(&bits, &shifted, sizeof(bits));
+    bits = (bits + 1023) << 52;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+/* log(x) for positive normal x without branches, so loops calling it vectorize.
+   x = m * 2^e with m in [sqrt(1/2), sqrt(2)), and log(m) = 2 atanh((m-1)/(m+1)).
+   Offsetting the bits by those of sqrt(1/2) before splitting them selects the
+   range of m with integer arithmetic only; the biased exponent is turned into
+   a double by placing it in the mantissa of 2^52. log(0) returns about -709. */
+static inline double simdLog(double x) {
+    uint64_t bits, biasedExponent, exponentBits;
+    double m, e, s, s2, p;
+
+    memcpy(&bits, &x, sizeof(bits));
+    biasedExponent = (bits + 0x4000000000000000ULL - 0x3fe6a09e667f3bcdULL) >> 52;
+    bits = bits - (biasedExponent << 52) + 0x4000000000000000ULL;
+    memcpy(&m, &bits, sizeof(m));
+    exponentBits = biasedExponent | 0x4330000000000000ULL;
+    memcpy(&e, &exponentBits, sizeof(e));
+    e -= 4503599627370496.0 + 1024;
+
+    s = (m - 1) / (m + 1);
+    s2 = s * s;
+    p = 1.0 / 21;
+    p = p * s2 + 1.0 / 19;
+    p = p * s2 + 1.0 / 17;
+    p = p * s2 + 1.0 / 15;
+    p = p * s2 + 1.0 / 13;
+    p = p * s2 + 1.0 / 11;
+    p = p * s2 + 1.0 / 9;
+    p = p * s2 + 1.0 / 7;
+    p = p * s2 + 1.0 / 5;
+    p = p * s2 + 1.0 / 3;
+    p = p * s2 + 1.0;
+    return e * 6.93147180369123816490e-01 + (e * 1.90821492927058770002e-10 + 2 * s * p);
+}
+
+/* sqrt(x) for x >= 0 as exp(log(x) / 2), accurate to a few units in the last
+   place; unlike sqrt() it has no errno check, so loops calling it vectorize.
+   Returns about 1e-154 for x == 0. */
+static inline double simdSqrt(double x) {
+    return simdExp(0.5 * simdLog(x));
+}
+
+/* Uniform double in [0, 1) from the top 52 bits of a hash, without an
+   integer-to-double conversion so loops calling it vectorize */
+static inline double uniformFromBits(uint64_t h) {
+    uint64_t bits = (h >> 12) | 0x3ff0000000000000ULL;
+    double u;
+    memcpy(&u, &bits, sizeof(u));
+    return u - 1.0;
+}
+
+/* Two standard normal variates per lane by the Box-Muller transform.
+   Lane j uses counters `counter` and `counter + 1` of stream keys[j], so the
+   values depend only on (seed, path, step) and not on how work is split up.
+   cos and sin of the angle come from a half-angle polynomial pair, so the whole
+   loop is branch-free and vectorizes. */
+void simulationNormals(const uint64_t* keys, uint64_t counter, double* zCos, double* zSin) {
+    for (int j = 0; j < SIM_LANES; j++) {
+        double u1 = 1.0 - uniformFromBits(mix64(keys[j] + counter));
+        double u2 = uniformFromBits(mix64(keys[j] + counter + 1));
+        double radius = simdSqrt(-2.0 * simdLog(u1));
+        double h = 3.141592653589793 * u2 - 1.5707963267948966;
+        double h2 = h * h;
+        double s = 1.0 / 121645100408832000.0;
+        double c = 1.0 / 2432902008176640000.0;
+
+        s = s * h2 - 1.0 / 355687428096000.0;
+        s = s * h2 + 1.0 / 1307674368000.0;
+        s = s * h2 - 1.0 / 6227020800.0;
+        s = s * h2 + 1.0 / 39916800.0;
+        s = s * h2 - 1.0 / 362880.0;
+        s = s * h2 + 1.0 / 5040.0;
+        s = s * h2 - 1.0 / 120.0;
+        s = s * h2 + 1.0 / 6.0;
+        s = s * h2 - 1.0;
+        s = -s * h;
+
+        c = c * h2 - 1.0 / 6402373705728000.0;
+        c = c * h2 + 1.0 / 20922789888000.0;
+        c = c * h2 - 1.0 / 87178291200.0;
+        c = c * h2 + 1.0 / 479001600.0;
+        c = c * h2 - 1.0 / 3628800.0;
+        c = c * h2 + 1.0 / 40320.0;
+        c = c * h2 - 1.0 / 720.0;
+        c = c * h2 + 1.0 / 24.0;
+        c = c * h2 - 0.5;
+        c = c * h2 + 1.0;
+
+        /* The angle is 2h in [-pi, pi): use the double-angle formulas */
+        zCos[j] = radius * (1.0 - 2.0 * s * s);
+        zSin[j] = radius * (2.0 * s * c);
+    }
+}
+
+/* Thread body: claim chunks of paths until all have been simulated.
+   Every block of SIM_LANES paths is advanced with full-width lane loops; lanes
+   past the end of the last chunk simulate paths that are never stored. */
+void* simulationWorker(void* arg) {
+    Simulation* sim = (Simulation*)arg;
+    double dt = 1.0 / sim->n;
+    double decay = exp(-sim->a * dt);
+    double vasicekScale = sim->sigma * sqrt((1 - exp(-2 * sim->a * dt)) / (2 * sim->a));
+    double cirScale = sim->sigma * sqrt(dt);
+    double target = sim->target;
+    /* CIR compounds with the truncated rate max(r, 0), as in its variance term */
+    double rateFloor = sim->model == MODEL_CIR ? 0.0 : -INFINITY;
+
+    while (1) {
+        long start = atomic_fetch_add(&sim->nextChunk, 1) * SIM_CHUNK_PATHS;
+        long end = start + SIM_CHUNK_PATHS;
+        if (start >= sim->paths) {
+            break;
+        }
+        if (end > sim->paths) {
+            end = sim->paths;
+        }
+
+        for (long first = start; first < end; first += SIM_LANES) {
+            double r[SIM_LANES], B[SIM_LANES], hit[SIM_LANES];
+            double zCos[SIM_LANES], zSin[SIM_LANES];
+            uint64_t keys[SIM_LANES];
+            int lanes = end - first < SIM_LANES ? (int)(end - first) : SIM_LANES;
+
+            for (int j = 0; j < SIM_LANES; j++) {
+                keys[j] = mix64(sim->seed ^ mix64((uint64_t)(first + j) + 0x9e3779b97f4a7c15ULL));
+                r[j] = sim->r0;
+                B[j] = sim->P;
+                hit[j] = B[j] >= target ? 0.0 : -1.0;
+            }
+
+            for (long k = 0; k < sim->steps; k++) {
+                double* z = k % 2 == 0 ? zCos : zSin;
+
+                if (sim->model == MODEL_BOOTSTRAP) {
+                    /* Historical rates are annual: draw one per simulated year */
+                    if (k % sim->n == 0) {
+                        for (int j = 0; j < SIM_LANES; j++) {
+                            uint64_t h = mix64(mix64(keys[j] ^ 0xb0075724a9e5ULL) + (uint64_t)(k / sim->n));
+                            r[j] = sim->history[h % (uint64_t)sim->historyCount];
+                        }
+                    }
+                } else if (k % 2 == 0) {
+                    simulationNormals(keys, (uint64_t)k, zCos, zSin);
+                }
+
+                double elapsed = (k + 1) * dt;
+                for (int j = 0; j < SIM_LANES; j++) {
+                    double rate = r[j] > rateFloor ? r[j] : rateFloor;
+                    B[j] *= 1 + rate * dt;
+                    hit[j] = hit[j] < 0 && B[j] >= target ? elapsed : hit[j];
+                }
+
+                if (sim->model == MODEL_VASICEK) {
+                    for (int j = 0; j < SIM_LANES; j++) {
+                        r[j] = sim->b + (r[j] - sim->b) * decay + vasicekScale * z[j];
+                    }
+                } else if (sim->model == MODEL_CIR) {
+                    /* Full-truncation Euler step keeps the variance term real;
+                       max(r, 0) is written as (r + |r|) / 2, which is exact and keeps the loop branch-free */
+                    for (int j = 0; j < SIM_LANES; j++) {
+                        double rPlus = 0.5 * (r[j] + fabs(r[j]));
+                        r[j] += sim->a * (sim->b - rPlus) * dt + cirScale * simdSqrt(rPlus) * z[j];
+                    }
+                }
+            }
+
+            for (int j = 0; j < lanes; j++) {
+                sim->finals[first + j] = B[j];
+                sim->times[first + j] = hit[j];
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Run worker(arg) on the given number of threads, one of them the calling thread,
+   and wait for all of them. Workers share arg and claim their own work from it.
+   Returns 0 on success, or -1 if some threads could not be started. */
+int runWorkers(void* (*worker)(void*), void* arg, int threads) {
+    pthread_t workers[WORKER_MAX_THREADS];
+    int started = 0;
+
+    for (int i = 1; i < threads && i < WORKER_MAX_THREADS; i++) {
+        if (pthread_create(&workers[started], NULL, worker, arg) != 0) {
+            break;
+        }
+        started++;
+    }
+    worker(arg);
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    return started == threads - 1 ? 0 : -1;
+}
+
+/* Simulate every path of sim on the given number of threads.
+   Returns 0 on success, or -1 if the threads could not be started. */
+int runSimulation(Simulation* sim, int threads) {
+    atomic_store(&sim->nextChunk, 0);
+    return runWorkers(simulationWorker, sim, threads);
+}
+
+/* Comparison function for qsort on doubles */
+int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Linearly interpolated percentile q (0-100) of a sorted array */
+double percentile(const double* sorted, long count, double q) {
+    double position = q / 100.0 * (count - 1);
+    long below = (long)position;
+    if (below + 1 >= count) {
+        return sorted[count - 1];
+    }
+    return sorted[below] + (position - below) * (sorted[below + 1] - sorted[below]);
+}
+
+/* Read historical annual rates (in decimal, whitespace separated) from a file.
+   Returns the number of rates read, or -1 if the file could not be opened. */
+int loadRateHistory(const char* filename, double* rates, int maxRates) {
+    FILE* in = fopen(filename, "r");
+    int count = 0;
+    if (in == NULL) {
+        return -1;
+    }
+    while (count < maxRates && fscanf(in, "%lf", &rates[count]) == 1) {
+        count++;
+    }
+    fclose(in);
+    return count;
+}
+
+/* x / d rounded to the nearest integer, ties to even (banker's rounding) */
+uint128 divideHalfEven(uint128 x, uint128 d) {
+    uint128 q = x / d;
+    uint128 rem = x % d;
+    if (2 * rem > d || (2 * rem == d && (q & 1))) {
+        q++;
+    }
+    return q;
+}
+
+/* Full 256-bit product of a and b, as its high and low 128 bits */
+void multiplyWide(uint128 a, uint128 b, uint128* high, uint128* low) {
+    uint128 a0 = (uint64_t)a, a1 = a >> 64, b0 = (uint64_t)b, b1 = b >> 64;
+    uint128 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint128 middle = (p00 >> 64) + (uint64_t)p01 + (uint64_t)p10;
+
+    *low = (middle << 64) | (uint64_t)p00;
+    *high = p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64);
+}
+
+/* numerator / denominator, rounded half to even to 128 bits.
+   Requires numerator >= denominator > 0 and denominator < 2^126. */
+WideNumber wideRatio(uint128 numerator, uint128 denominator) {
+    WideNumber result;
+    uint128 quotient = numerator / denominator;
+    uint128 rem = numerator % denominator;
+    int bits = 0;
+
+    while (bits < 128 && (quotient >> bits) != 0) {
+        bits++;
+    }
+    result.mantissa = quotient << (128 - bits);
+    result.exponent = bits - 128;
+    for (int i = 127 - bits; i >= 0; i--) {
+        rem *= 2;
+        if (rem >= denominator) {
+            rem -= denominator;
+            result.mantissa |= (uint128)1 << i;
+        }
+    }
+    if (2 * rem > denominator || (2 * rem == denominator && (result.mantissa & 1))) {
+        result.mantissa++;
+        if (result.mantissa == 0) {
+            result.mantissa = (uint128)1 << 127;
+            result.exponent++;
+        }
+    }
+    return result;
+}
+
+/* a * b, rounded half to even to 128 bits */
+WideNumber wideMultiply(WideNumber a, WideNumber b) {
+    WideNumber result;
+    uint128 high, low, rest, half;
+    int roundUp;
+
+    multiplyWide(a.mantissa, b.mantissa, &high, &low);
+    if (high >> 127) {
+        result.mantissa = high;
+        result.exponent = a.exponent + b.exponent + 128;
+        half = (uint128)1 << 127;
+        rest = low;
+    } else {
+        result.mantissa = (high << 1) | (low >> 127);
+        result.exponent = a.exponent + b.exponent + 127;
+        half = (uint128)1 << 126;
+        rest = low & (((uint128)1 << 127) - 1);
+    }
+    roundUp = rest > half || (rest == half && (result.mantissa & 1));
+    if (roundUp) {
+        result.mantissa++;
+        if (result.mantissa == 0) {
+            result.mantissa = (uint128)1 << 127;
+            result.exponent++;
+        }
+    }
+    return result;
+}
+
+/* g^k for g >= 1, by exponentiation by squaring. Every step rounds by at most
+   2^-128 relative, so the result is within about (k + 2 log2 k) * 2^-128 of g^k.
+   Returns 0 on success, or -1 once the power exceeds 2^200. */
+int widePower(WideNumber g, long k, WideNumber* result) {
+    WideNumber power = {(uint128)1 << 127, -127};
+
+    while (k > 0) {
+        if (k & 1) {
+            power = wideMultiply(power, g);
+        }
+        k >>= 1;
+        if (k > 0) {
+            g = wideMultiply(g, g);
+        }
+        if (power.exponent + 127 > 200 || g.exponent + 127 > 200) {
+            return -1;
+        }
+    }
+    *result = power;
+    return 0;
+}
+
+/* cents * growth rounded half to even to whole cents, for growth >= 1.
+   Returns 0 on success, or -1 if the result exceeds FIXED_MAX_CENTS. */
+int wideCents(uint128 cents, WideNumber growth, uint128* result) {
+    long whole = growth.exponent + 127;
+    uint128 high, low, rest, half, q;
+    int shift;
+
+    if (cents == 0) {
+        *result = 0;
+        return 0;
+    }
+    /* growth is in [2^whole, 2^(whole+1)), so whole > 53 cannot fit in FIXED_MAX_CENTS */
+    if (whole > 53) {
+        return -1;
+    }
+    shift = (int)(127 - whole);
+    multiplyWide(cents, growth.mantissa, &high, &low);
+    q = (high << (128 - shift)) | (low >> shift);
+    rest = low & (((uint128)1 << shift) - 1);
+    half = (uint128)1 << (shift - 1);
+    if (rest > half || (rest == half && (q & 1))) {
+        q++;
+    }
+    if (q > (uint128)FIXED_MAX_CENTS) {
+        return -1;
+    }
+    *result = q;
+    return 0;
+}
+
+/* Per-period growth factor 1 + r/n as the exact ratio numerator / denominator,
+   with r read to RATE_SCALE. r must be in [0, FIXED_MAX_RATE]. */
+void growthRatio(double r, int n, uint128* numerator, uint128* denominator) {
+    uint128 rate = (uint128)nearbyint(r * RATE_SCALE);
+    *denominator = (uint128)n * RATE_SCALE;
+    *numerator = *denominator + rate;
+}
+
+/* Balance in cents after k periods, rounding once: cents * (numerator / denominator)^k
+   rounded half to even. With the ratio in lowest terms, the exact balance can only be a
+   whole or half cent when denominator^k divides 2 * cents; that case is computed with
+   integers, every other one with 128-bit mantissas whose error is far below a cent.
+   Returns 0 on success, or -1 if the balance exceeds FIXED_MAX_CENTS. */
+int exactCentsBalance(uint128 cents, uint128 numerator, uint128 denominator, long k, uint128* result) {
+    uint128 a = numerator, b = denominator, divisor = 1;
+    WideNumber growth;
+    long j;
+
+    while (b != 0) {
+        uint128 remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    numerator /= a;
+    denominator /= a;
+
+    if (numerator == 1 || cents == 0) {
+        *result = cents;
+        return 0;
+    }
+    for (j = 0; j < k && denominator != 1 && divisor * denominator <= 2 * cents; j++) {
+        divisor *= denominator;
+    }
+    if ((j == k || denominator == 1) && (2 * cents) % divisor == 0) {
+        uint128 twice = 2 * cents / divisor;
+        for (j = 0; j < k; j++) {
+            if (twice > (uint128)(2 * FIXED_MAX_CENTS) / numerator) {
+                return -1;
+            }
+            twice *= numerator;
+        }
+        *result = divideHalfEven(twice, 2);
+        return 0;
+    }
+
+    if (widePower(wideRatio(numerator, denominator), k, &growth) != 0) {
+        return -1;
+    }
+    return wideCents(cents, growth, result);
+}
+
+/* Balance in cents after k periods, rounding to whole cents after every period
+   as a ledger does: each period multiplies by numerator / denominator exactly
+   and rounds half to even. Returns 0 on success, or -1 if the balance exceeds FIXED_MAX_CENTS. */
+int ledgerCentsBalance(uint128 cents, uint128 numerator, uint128 denominator, long k, uint128* result) {
+    for (long i = 0; i < k; i++) {
+        cents = divideHalfEven(cents * numerator, denominator);
+        if (cents > (uint128)FIXED_MAX_CENTS) {
+            return -1;
+        }
+    }
+    *result = cents;
+    return 0;
+}
+
+/* Balance after t years (option 1) */
+double findBalance(double P, double r, int n, double t) {
+    return P * pow(1 + r / n, n * t);
+}
+
+/* Principal needed to reach B after t years (option 2) */
+double findPrincipal(double r, int n, double t, double B) {
+    return B / pow(1 + r / n, n * t);
+}
+
+/* Interest rate that grows P to B in t years (option 3) */
+double findRate(int n, double t, double P, double B) {
+    return n * (exp(log(B / P) / (n * t)) - 1);
+}
+
+/* Compounding frequency from 1 to 12 that grows P to B in t years (option 4).
+   Returns -1 if no frequency matches B to the cent. */
+int findFrequency(double t, double r, double P, double B) {
+    for (int i = 1; i <= 12; i++) {
+        double j = P * pow(1 + r / i, i * t);
+        if (fabs(j - B) < 0.01) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Years needed to grow P to B (option 5) */
+double findTime(int n, double r, double P, double B) {
+    return log(B / P) / (n * log(1 + r / n));
+}
+
+/* Evaluate one daemon query. The arguments are given in the order the menu asks for them:
+   B: P r n t, P: r n t B, R: n t P B, N: t r P B, T: n r P B.
+   Returns 0 on success, or -1 if the operation or an argument is invalid. */
+int evaluateQuery(char op, const double args[4], double* value) {
+    int nIndex;
+
+    for (int i = 0; i < 4; i++) {
+        if (!(args[i] > 0) || isinf(args[i])) {
+            return -1;
+        }
+    }
+    if (op == 'B') {
+        nIndex = 2;
+    } else if (op == 'P') {
+        nIndex = 1;
+    } else if (op == 'R' || op == 'T') {
+        nIndex = 0;
+    } else if (op == 'N') {
+        nIndex = -1;
+    } else {
+        return -1;
+    }
+    if (nIndex >= 0 && (args[nIndex] != floor(args[nIndex]) || args[nIndex] > 1000000)) {
+        return -1;
+    }
+
+    if (op == 'B') {
+        *value = findBalance(args[0], args[1], (int)args[2], args[3]);
+    } else if (op == 'P') {
+        *value = findPrincipal(args[0], (int)args[1], args[2], args[3]);
+    } else if (op == 'R') {
+        *value = findRate((int)args[0], args[1], args[2], args[3]);
+    } else if (op == 'N') {
+        *value = findFrequency(args[0], args[1], args[2], args[3]);
+    } else {
+        *value = findTime((int)args[0], args[1], args[2], args[3]);
+    }
+    return 0;
+}
+
+/* Microseconds elapsed since begin */
+double elapsedMicroseconds(const struct timespec* begin) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - begin->tv_sec) * 1e6 + (now.tv_nsec - begin->tv_nsec) / 1e3;
+}
+
+/* Remember the latency of requests that were answered together */
+void recordLatency(double microseconds, long requests) {
+    for (long i = 0; i < requests; i++) {
+        daemonLatencies[daemonRequestCount % DAEMON_LATENCY_SAMPLES] = microseconds;
+        daemonRequestCount++;
+    }
+}
+
+/* Median and 99th percentile latency over the most recent requests */
+void latencyPercentiles(double* p50, double* p99, long* count) {
+    static double sorted[DAEMON_LATENCY_SAMPLES];
+    long samples = daemonRequestCount < DAEMON_LATENCY_SAMPLES ? daemonRequestCount : DAEMON_LATENCY_SAMPLES;
+
+    *count = daemonRequestCount;
+    *p50 = 0;
+    *p99 = 0;
+    if (samples > 0) {
+        memcpy(sorted, daemonLatencies, samples * sizeof(double));
+        qsort(sorted, samples, sizeof(double), compareDoubles);
+        *p50 = percentile(sorted, samples, 50);
+        *p99 = percentile(sorted, samples, 99);
+    }
+}
+
+/* Answer every complete request waiting in the client's input buffer.
+   All requests that arrived in one read are answered together and their
+   responses are sent with a single write by the event loop. */
+void processClient(DaemonClient* client) {
+    size_t used = 0;
+
+    while (used < client->inLength && client->outLength + 128 <= DAEMON_BUFFER_SIZE) {
+        char* request = client->in + used;
+        size_t available = client->inLength - used;
+        double value;
+
+        if ((unsigned char)request[0] == DAEMON_BINARY_MAGIC) {
+            DaemonRequest binary;
+            DaemonResponse response;
+            if (available < sizeof(binary)) {
+                break;
+            }
+            memcpy(&binary, request, sizeof(binary));
+            response.status = evaluateQuery((char)binary.op, binary.args, &value);
+            response.padding = 0;
+            response.value = response.status == 0 ? value : 0;
+            memcpy(client->out + client->outLength, &response, sizeof(response));
+            client->outLength += sizeof(response);
+            used += sizeof(binary);
+        } else {
+            char* newline = memchr(request, '\n', available);
+            char op;
+            double args[4];
+            int length;
+
+            if (newline == NULL) {
+                if (available == DAEMON_BUFFER_SIZE) {
+                    client->inLength = 0;
+                    return;
+                }
+                break;
+            }
+            *newline = '\0';
+            if (strncmp(request, "STATS", 5) == 0) {
+                double p50, p99;
+                long count;
+                latencyPercentiles(&p50, &p99, &count);
+                length = snprintf(client->out + client->outLength, 128,
+                                  "OK requests=%ld p50_us=%.2f p99_us=%.2f\n", count, p50, p99);
+            } else if (sscanf(request, " %c %lf %lf %lf %lf", &op, &args[0], &args[1], &args[2], &args[3]) == 5 &&
+                       evaluateQuery(op, args, &value) == 0) {
+                length = snprintf(client->out + client->outLength, 128, "OK %.17g\n", value);
+            } else {
+                length = snprintf(client->out + client->outLength, 128, "ERR invalid request\n");
+            }
+            client->outLength += length;
+            used = newline - client->in + 1;
+        }
+        client->pending++;
+    }
+
+    memmove(client->in, client->in + used, client->inLength - used);
+    client->inLength -= used;
+}
+
+/* Signal handler that asks the daemon to stop */
+void stopDaemon(int signal) {
+    (void)signal;
+    daemonStopping = 1;
+}
+
+/* Serve queries on a Unix domain socket until SIGINT or SIGTERM.
+   A single poll() loop handles every client, so no state grows per request.
+   The latency reported by STATS runs from the poll() wakeup at which a request
+   was read until its response has been completely written to the socket, so
+   requests answered together share the latency of their batch. */
+int runDaemon(const char* path) {
+    static DaemonClient clients[DAEMON_MAX_CLIENTS];
+    struct pollfd fds[DAEMON_MAX_CLIENTS + 1];
+    struct sockaddr_un address;
+    struct stat existing, bound;
+    struct timespec woke;
+    int listener;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path is too long: %s\n", path);
+        return 1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("Could not create socket");
+        return 1;
+    }
+    /* Only a stale socket left by an earlier daemon may be replaced:
+       one that nothing accepts connections on any more */
+    if (lstat(path, &existing) == 0) {
+        int probe;
+        int refused;
+
+        if (!S_ISSOCK(existing.st_mode)) {
+            fprintf(stderr, "Refusing to replace %s: it exists and is not a socket.\n", path);
+            close(listener);
+            return 1;
+        }
+        probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        refused = probe >= 0 && connect(probe, (struct sockaddr*)&address, sizeof(address)) != 0 &&
+                  errno == ECONNREFUSED;
+        if (probe >= 0) {
+            close(probe);
+        }
+        if (!refused) {
+            fprintf(stderr, "Refusing to replace %s: another daemon is listening on it.\n", path);
+            close(listener);
+            return 1;
+        }
+        unlink(path);
+    }
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, DAEMON_MAX_CLIENTS) != 0 || lstat(path, &bound) != 0) {
+        perror("Could not listen on socket");
+        close(listener);
+        return 1;
+    }
+    fcntl(listener, F_SETFL, O_NONBLOCK);
+    signal(SIGINT, stopDaemon);
+    signal(SIGTERM, stopDaemon);
+    signal(SIGPIPE, SIG_IGN);
+    for (int i = 0; i < DAEMON_MAX_CLIENTS; i++) {
+        clients[i].fd = -1;
+    }
+    printf("Listening on %s\n", path);
+    fflush(stdout);
+
+    while (!daemonStopping) {
+        fds[0].fd = listener;
+        fds[0].events = POLLIN;
+        for (int i = 0; i < DAEMON_MAX_CLIENTS; i++) {
+            fds[i + 1].fd = clients[i].fd;
+            fds[i + 1].events = clients[i].outLength > 0 ? POLLOUT : POLLIN;
+        }
+        if (poll(fds, DAEMON_MAX_CLIENTS + 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("poll");
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &woke);
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listener, NULL, NULL)) >= 0) {
+                int slot = 0;
+                while (slot < DAEMON_MAX_CLIENTS && clients[slot].fd != -1) {
+                    slot++;
+                }
+                if (slot == DAEMON_MAX_CLIENTS) {
+                    close(fd);
+                    continue;
+                }
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                clients[slot].fd = fd;
+                clients[slot].inLength = 0;
+                clients[slot].outLength = 0;
+                clients[slot].pending = 0;
+            }
+        }
+
+        for (int i = 0; i < DAEMON_MAX_CLIENTS; i++) {
+            DaemonClient* client = &clients[i];
+            int closing = 0;
+
+            if (client->fd < 0 || fds[i + 1].revents == 0) {
+                continue;
+            }
+            if (fds[i + 1].revents & POLLIN) {
+                ssize_t received = read(client->fd, client->in + client->inLength, DAEMON_BUFFER_SIZE - client->inLength);
+                if (received > 0) {
+                    client->inLength += received;
+                    client->woke = woke;
+                    processClient(client);
+                } else if (received == 0 || (errno != EAGAIN && errno != EINTR)) {
+                    closing = 1;
+                }
+            } else if (fds[i + 1].revents & (POLLERR | POLLHUP)) {
+                closing = 1;
+            }
+            if (!closing && client->outLength > 0) {
+                ssize_t sent = write(client->fd, client->out, client->outLength);
+                if (sent > 0) {
+                    memmove(client->out, client->out + sent, client->outLength - sent);
+                    client->outLength -= sent;
+                    if (client->outLength == 0) {
+                        recordLatency(elapsedMicroseconds(&client->woke), client->pending);
+                        client->pending = 0;
+                        client->woke = woke;
+                        processClient(client);
+                    }
+                } else if (sent < 0 && errno != EAGAIN && errno != EINTR) {
+                    closing = 1;
+                }
+            }
+            if (closing) {
+                close(client->fd);
+                client->fd = -1;
+            }
+        }
+    }
 
-/* Function declarations */
-void menu();
-void continueOrExit();
-double getValidInput(const char* prompt);
-int getValidIntInput(const char* prompt);
+    for (int i = 0; i < DAEMON_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) {
+            close(clients[i].fd);
+        }
+    }
+    close(listener);
 
-/* Main function */
-int main()
-{
-    menu();
+    /* Leave the path alone if another daemon has been bound to it since */
+    if (lstat(path, &existing) == 0 && existing.st_dev == bound.st_dev && existing.st_ino == bound.st_ino) {
+        unlink(path);
+    }
     return 0;
 }
 
-/* Function to validate double input */
-double getValidInput(const char* prompt) {
-    double value;
-    printf("%s", prompt);
-    while (scanf("%lf", &value) != 1 || value <= 0) {
-        printf("Invalid input. Please enter a valid positive number.\n");
-        while (getchar() != '\n');
+/* Days since 1970-01-01 of a proleptic Gregorian date */
+long daysFromCivil(int year, int month, int day) {
+    long era;
+    long yearOfEra, dayOfYear, dayOfEra;
+
+    year -= month <= 2;
+    era = (year >= 0 ? year : year - 399) / 400;
+    yearOfEra = year - era * 400;
+    dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/* Whether year-month-day is a date of the Gregorian calendar */
+int isValidDate(int year, int month, int day) {
+    static const int monthDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+    if (month < 1 || month > 12 || day < 1) {
+        return 0;
     }
-    return value;
+    return day <= monthDays[month - 1] + (month == 2 && leap);
 }
 
-/* Function to validate integer input */
-int getValidIntInput(const char* prompt) {
-    int value;
-    char ch1;
+/* Comparison function for qsort on pointers to account identifiers */
+int compareIds(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+/* Read lines of the form "account YYYY-MM-DD amount" into book.
+   The flows of an account must be on consecutive lines and in date order, and
+   an account may appear only once; an account that breaks these rules or has an
+   invalid date is skipped with a message.
+   Returns 0 on success, or -1 if the file could not be read. */
+int loadCashFlows(const char* filename, CashFlowBook* book) {
+    FILE* in = fopen(filename, "r");
+    char line[256];
+    char id[XIRR_ID_LENGTH];
+    char* skipped;                     // Whether each account read so far is to be skipped
+    const char** sorted;
+    long flowCapacity = 1024, accountCapacity = 256;
+    long firstDay = 0, lastDay = 0, lineNumber = 0, kept = 0, keptFlows = 0;
+    int year, month, day, failed = 0;
+    double amount;
+
+    memset(book, 0, sizeof(*book));
+    if (in == NULL) {
+        return -1;
+    }
+    book->ids = malloc(accountCapacity * sizeof(*book->ids));
+    book->firstFlow = malloc((accountCapacity + 1) * sizeof(long));
+    book->years = malloc(flowCapacity * sizeof(double));
+    book->amounts = malloc(flowCapacity * sizeof(double));
+    skipped = malloc(accountCapacity);
+    failed = book->ids == NULL || book->firstFlow == NULL || book->years == NULL || book->amounts == NULL ||
+             skipped == NULL;
+
+    while (!failed && fgets(line, sizeof(line), in) != NULL) {
+        long account = book->accountCount - 1;
+        long today;
+
+        lineNumber++;
+        if (sscanf(line, "%31s %d-%d-%d %lf", id, &year, &month, &day, &amount) != 5) {
+            if (sscanf(line, " %c", id) == 1) {
+                printf("Skipping malformed line %ld.\n", lineNumber);
+            }
+            continue;
+        }
+
+        if (account < 0 || strcmp(book->ids[account], id) != 0) {
+            if (book->accountCount == accountCapacity) {
+                char (*ids)[XIRR_ID_LENGTH] = realloc(book->ids, 2 * accountCapacity * sizeof(*book->ids));
+                long* firstFlow;
+                char* moreSkipped;
+
+                if (ids != NULL) {
+                    book->ids = ids;
+                }
+                firstFlow = realloc(book->firstFlow, (2 * accountCapacity + 1) * sizeof(long));
+                if (firstFlow != NULL) {
+                    book->firstFlow = firstFlow;
+                }
+                moreSkipped = realloc(skipped, 2 * accountCapacity);
+                if (moreSkipped != NULL) {
+                    skipped = moreSkipped;
+                }
+                if (ids == NULL || firstFlow == NULL || moreSkipped == NULL) {
+                    failed = 1;
+                    break;
+                }
+                accountCapacity *= 2;
+            }
+            account = book->accountCount++;
+            strcpy(book->ids[account], id);
+            book->firstFlow[account] = book->flowCount;
+            skipped[account] = 0;
+            firstDay = lastDay = isValidDate(year, month, day) ? daysFromCivil(year, month, day) : 0;
+        }
+        if (skipped[account]) {
+            continue;
+        }
+
+        if (!isValidDate(year, month, day)) {
+            printf("Skipping account %s: line %ld has an invalid date.\n", id, lineNumber);
+            skipped[account] = 1;
+        } else if ((today = daysFromCivil(year, month, day)) < lastDay) {
+            printf("Skipping account %s: line %ld is dated before the line above it.\n", id, lineNumber);
+            skipped[account] = 1;
+        }
+        if (skipped[account]) {
+            book->flowCount = book->firstFlow[account];
+            continue;
+        }
+        lastDay = today;
+
+        if (book->flowCount == flowCapacity) {
+            double* years = realloc(book->years, 2 * flowCapacity * sizeof(double));
+            double* amounts;
+
+            if (years != NULL) {
+                book->years = years;
+            }
+            amounts = realloc(book->amounts, 2 * flowCapacity * sizeof(double));
+            if (amounts != NULL) {
+                book->amounts = amounts;
+            }
+            if (years == NULL || amounts == NULL) {
+                failed = 1;
+                break;
+            }
+            flowCapacity *= 2;
+        }
+        book->years[book->flowCount] = (today - firstDay) / 365.0;
+        book->amounts[book->flowCount] = amount;
+        book->flowCount++;
+    }
+    fclose(in);
+
+    /* An account whose lines are split into several groups cannot be told
+       apart from two accounts that share an id, so every group is skipped */
+    sorted = failed ? NULL : malloc((book->accountCount + 1) * sizeof(*sorted));
+    if (sorted == NULL) {
+        free(skipped);
+        freeCashFlows(book);
+        return -1;
+    }
+    for (long i = 0; i < book->accountCount; i++) {
+        sorted[i] = book->ids[i];
+    }
+    qsort(sorted, book->accountCount, sizeof(*sorted), compareIds);
+    for (long i = 0, j; i < book->accountCount; i = j) {
+        for (j = i + 1; j < book->accountCount && strcmp(sorted[i], sorted[j]) == 0; j++) {
+        }
+        if (j - i > 1) {
+            printf("Skipping account %s: its lines are not consecutive.\n", sorted[i]);
+            for (long k = i; k < j; k++) {
+                skipped[(sorted[k] - book->ids[0]) / XIRR_ID_LENGTH] = 1;
+            }
+        }
+    }
+    free(sorted);
+
+    /* Close the gaps left by the skipped accounts */
+    book->firstFlow[book->accountCount] = book->flowCount;
+    for (long i = 0; i < book->accountCount; i++) {
+        long first = book->firstFlow[i], count = book->firstFlow[i + 1] - first;
+
+        if (skipped[i]) {
+            continue;
+        }
+        memmove(book->ids[kept], book->ids[i], sizeof(*book->ids));
+        memmove(book->years + keptFlows, book->years + first, count * sizeof(double));
+        memmove(book->amounts + keptFlows, book->amounts + first, count * sizeof(double));
+        book->firstFlow[kept++] = keptFlows;
+        keptFlows += count;
+    }
+    free(skipped);
+    book->accountCount = kept;
+    book->flowCount = keptFlows;
+    book->firstFlow[kept] = keptFlows;
+
+    book->rates = malloc((book->accountCount + 1) * sizeof(double));
+    book->iterations = malloc((book->accountCount + 1) * sizeof(int));
+    if (book->rates == NULL || book->iterations == NULL) {
+        freeCashFlows(book);
+        return -1;
+    }
+    return 0;
+}
+
+/* Release the arrays of a cash-flow book */
+void freeCashFlows(CashFlowBook* book) {
+    free(book->ids);
+    free(book->firstFlow);
+    free(book->years);
+    free(book->amounts);
+    free(book->rates);
+    free(book->iterations);
+    memset(book, 0, sizeof(*book));
+}
+
+/* Net present value of the flows at an annual rate, and its derivative with respect to the rate.
+   One exp per flow; log1p(rate) is computed once per call. */
+void presentValue(const double* years, const double* amounts, long count, double rate,
+                  double* value, double* derivative) {
+    double logGrowth = log1p(rate);
+    double sum = 0, slope = 0;
+
+    for (long i = 0; i < count; i++) {
+        double term = amounts[i] * exp(-years[i] * logGrowth);
+        sum += term;
+        slope -= years[i] * term;
+    }
+    *value = sum;
+    *derivative = slope / (1 + rate);
+}
+
+/* Annual effective rate at which the flows have zero present value.
+   Newton steps are taken from a bracketing interval; a step that leaves the
+   interval or does not halve the residual is replaced by bisection, so the
+   iteration always converges once a sign change has been found.
+   Returns NAN if the flows do not change sign over the search range. */
+double solveXirr(const double* years, const double* amounts, long count, int* iterations) {
+    double lo = XIRR_LOWER_BOUND, hi = XIRR_UPPER_BOUND;
+    double fLo, fHi, slope, rate = 0.05, value, previous = INFINITY;
+
+    *iterations = 0;
+    presentValue(years, amounts, count, lo, &fLo, &slope);
+    presentValue(years, amounts, count, hi, &fHi, &slope);
+    if (count < 2 || fLo * fHi > 0) {
+        return NAN;
+    }
+
+    for (int i = 1; i <= XIRR_MAX_ITERATIONS; i++) {
+        double next;
+
+        *iterations = i;
+        presentValue(years, amounts, count, rate, &value, &slope);
+        if (value == 0) {
+            return rate;
+        }
+        if ((value < 0) == (fLo < 0)) {
+            lo = rate;
+        } else {
+            hi = rate;
+        }
+
+        next = rate - value / slope;
+        if (!(next > lo && next < hi) || fabs(value) > 0.5 * fabs(previous)) {
+            next = 0.5 * (lo + hi);
+        }
+        previous = value;
+        if (fabs(next - rate) < XIRR_TOLERANCE * (1 + fabs(rate))) {
+            return next;
+        }
+        rate = next;
+    }
+    return rate;
+}
+
+/* Thread body: claim chunks of accounts until every account has been solved */
+void* xirrWorker(void* arg) {
+    CashFlowBook* book = (CashFlowBook*)arg;
 
-    printf("%s", prompt);
     while (1) {
-        if (scanf("%d", &value) != 1 || value <= 0) {
-            printf("Invalid input. Please enter a valid positive integer.\n");
-            while (getchar() != '\n');
+        long start = atomic_fetch_add(&book->nextChunk, 1) * XIRR_CHUNK_ACCOUNTS;
+        long end = start + XIRR_CHUNK_ACCOUNTS;
+        if (start >= book->accountCount) {
+            break;
+        }
+        if (end > book->accountCount) {
+            end = book->accountCount;
+        }
+        for (long a = start; a < end; a++) {
+            long first = book->firstFlow[a];
+            book->rates[a] = solveXirr(book->years + first, book->amounts + first,
+                                       book->firstFlow[a + 1] - first, &book->iterations[a]);
+        }
+    }
+    return NULL;
+}
+
+/* Option 1, pow form: P * (1 + r/n)^(n t) */
+double scalarPowForm(const BenchData* d, long i) {
+    return d->P[i] * pow(1 + d->r[i] / d->n[i], d->n[i] * d->t[i]);
+}
+
+void batchedPowForm(const BenchData* d, double* out) {
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        out[i] = d->P[i] * pow(1 + d->r[i] / d->n[i], d->n[i] * d->t[i]);
+    }
+}
+
+void simdPowForm(const BenchData* d, double* out) {
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        out[i] = d->P[i] * simdExp(d->n[i] * d->t[i] * simdLog(1 + d->r[i] / d->n[i]));
+    }
+}
+
+long double referencePowForm(const BenchData* d, long i) {
+    return d->P[i] * expl(d->n[i] * (long double)d->t[i] * log1pl((long double)d->r[i] / d->n[i]));
+}
+
+long double roundedPowForm(const BenchData* d, long i) {
+    double base = 1 + d->r[i] / d->n[i], periods = d->n[i] * d->t[i];
+    return d->P[i] * expl(periods * logl(base));
+}
+
+/* Option 3, exp(log()) form: n * (exp(log(B/P) / (n t)) - 1) */
+double scalarExpLogForm(const BenchData* d, long i) {
+    return d->n[i] * (exp(log(d->B[i] / d->P[i]) / (d->n[i] * d->t[i])) - 1);
+}
+
+void batchedExpLogForm(const BenchData* d, double* out) {
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        out[i] = d->n[i] * (exp(log(d->B[i] / d->P[i]) / (d->n[i] * d->t[i])) - 1);
+    }
+}
+
+void simdExpLogForm(const BenchData* d, double* out) {
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        out[i] = d->n[i] * (simdExp(simdLog(d->B[i] / d->P[i]) / (d->n[i] * d->t[i])) - 1);
+    }
+}
+
+long double referenceExpLogForm(const BenchData* d, long i) {
+    return d->n[i] * expm1l(logl((long double)d->B[i] / d->P[i]) / (d->n[i] * (long double)d->t[i]));
+}
+
+/* Every variant rounds the exp() result to a double near 1 before subtracting 1,
+   which costs up to 1e5 ULP of the result; the reference rounds it the same way. */
+long double roundedExpLogForm(const BenchData* d, long i) {
+    double ratio = d->B[i] / d->P[i], periods = d->n[i] * d->t[i];
+    double growth = (double)expl(logl(ratio) / periods);
+    return d->n[i] * ((long double)growth - 1);
+}
+
+/* Option 5, log-ratio form: log(B/P) / (n log(1 + r/n)) */
+double scalarLogRatioForm(const BenchData* d, long i) {
+    return log(d->B[i] / d->P[i]) / (d->n[i] * log(1 + d->r[i] / d->n[i]));
+}
+
+void batchedLogRatioForm(const BenchData* d, double* out) {
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        out[i] = log(d->B[i] / d->P[i]) / (d->n[i] * log(1 + d->r[i] / d->n[i]));
+    }
+}
+
+void simdLogRatioForm(const BenchData* d, double* out) {
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        out[i] = simdLog(d->B[i] / d->P[i]) / (d->n[i] * simdLog(1 + d->r[i] / d->n[i]));
+    }
+}
+
+long double referenceLogRatioForm(const BenchData* d, long i) {
+    return logl((long double)d->B[i] / d->P[i]) / (d->n[i] * log1pl((long double)d->r[i] / d->n[i]));
+}
+
+long double roundedLogRatioForm(const BenchData* d, long i) {
+    double ratio = d->B[i] / d->P[i], base = 1 + d->r[i] / d->n[i];
+    return logl(ratio) / (d->n[i] * logl(base));
+}
+
+/* Kernels measured by --bench */
+BenchKernel benchKernels[] = {
+    {"pow", scalarPowForm, batchedPowForm, simdPowForm, referencePowForm, roundedPowForm},
+    {"exp_log", scalarExpLogForm, batchedExpLogForm, simdExpLogForm, referenceExpLogForm, roundedExpLogForm},
+    {"log_ratio", scalarLogRatioForm, batchedLogRatioForm, simdLogRatioForm, referenceLogRatioForm, roundedLogRatioForm},
+};
+
+/* Names of the kernel variants, in the order used by measureKernel() */
+const char* benchVariants[BENCH_VARIANTS] = {"scalar", "batched", "simd"};
+
+/* Fill the inputs with a fixed pseudo-random mix of typical savings products:
+   a few hundred distinct rates, common compounding frequencies and 1-50 year horizons. */
+void fillBenchData(BenchData* data) {
+    static const int frequencies[] = {1, 2, 4, 12, 52, 365};
+
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        uint64_t h = mix64((uint64_t)i + 0x5eed);
+        data->P[i] = 100 + (mix64(h + 1) >> 11) * (1.0 / 9007199254740992.0) * 999900;
+        data->r[i] = 0.001 + (double)(mix64(h + 2) % BENCH_DISTINCT_RATES) * (0.149 / BENCH_DISTINCT_RATES);
+        data->n[i] = frequencies[mix64(h + 3) % 6];
+        data->t[i] = 1 + (mix64(h + 4) >> 11) * (1.0 / 9007199254740992.0) * 49;
+        data->B[i] = (double)referencePowForm(data, i);
+    }
+}
+
+/* Distance between value and reference in units in the last place of the reference */
+double ulpError(double value, long double reference) {
+    double rounded = (double)reference;
+    double ulp = nextafter(fabs(rounded), INFINITY) - fabs(rounded);
+    return (double)(fabsl((long double)value - reference) / ulp);
+}
+
+/* Seconds elapsed since begin */
+double secondsSince(const struct timespec* begin) {
+    return elapsedMicroseconds(begin) / 1e6;
+}
+
+/* Run one variant of a kernel over every sample for at least BENCH_ROUND_SECONDS.
+   Returns its throughput in millions of evaluations per second,
+   or -1 if the variant does not exist. */
+double measureRound(const BenchKernel* kernel, int variant, const BenchData* data, double* out) {
+    BatchKernel batch = variant == 1 ? kernel->batched : kernel->simd;
+    long evaluations = 0;
+    struct timespec begin;
+    double seconds;
+
+    if (variant != 0 && batch == NULL) {
+        return -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    do {
+        if (variant == 0) {
+            for (long i = 0; i < BENCH_SAMPLES; i++) {
+                out[i] = kernel->scalar(data, i);
+            }
         } else {
-            if (scanf("%c", &ch1) == 1 && ch1 != '\n') {
-                printf("Invalid input. Please enter a valid positive integer.\n");
-                while (getchar() != '\n');
+            batch(data, out);
+        }
+        evaluations += BENCH_SAMPLES;
+        seconds = secondsSince(&begin);
+    } while (seconds < BENCH_ROUND_SECONDS);
+    return evaluations / seconds / 1e6;
+}
+
+/* Combine the BENCH_ROUNDS throughputs of one kernel variant and compare its results
+   with both references. The throughput is the median of the rounds, so a few rounds
+   slowed down or sped up by other processes do not move it.
+   Returns a negative throughput if the variant does not exist. */
+BenchResult measureKernel(const BenchKernel* kernel, int variant, const BenchData* data, double* out, double* roundMops) {
+    BatchKernel batch = variant == 1 ? kernel->batched : kernel->simd;
+    BenchResult result = {-1, 0, 0, 0};
+
+    if (variant != 0 && batch == NULL) {
+        return result;
+    }
+    qsort(roundMops, BENCH_ROUNDS, sizeof(double), compareDoubles);
+    result.mops = percentile(roundMops, BENCH_ROUNDS, 50);
+
+    if (variant == 0) {
+        for (long i = 0; i < BENCH_SAMPLES; i++) {
+            out[i] = kernel->scalar(data, i);
+        }
+    } else {
+        batch(data, out);
+    }
+    for (long i = 0; i < BENCH_SAMPLES; i++) {
+        double error = ulpError(out[i], kernel->reference(data, i));
+        double roundedError = ulpError(out[i], kernel->rounded(data, i));
+        if (error > result.maxUlp) {
+            result.maxUlp = error;
+        }
+        if (roundedError > result.roundedUlp) {
+            result.roundedUlp = roundedError;
+        }
+        result.meanUlp += error / BENCH_SAMPLES;
+    }
+    return result;
+}
+
+/* Benchmark every kernel variant and compare with a stored baseline.
+   If baselineFile does not exist it is created from this run.
+   Returns 0, or 1 if a variant is more than BENCH_REGRESSION_TOLERANCE slower
+   than the baseline or less accurate than it. Accuracy is judged against the
+   reference from rounded inputs: the error from rounding 1 + r/n is the same
+   for every variant and would hide a worse exp or log. */
+int runBenchmark(const char* baselineFile) {
+    static BenchData data;
+    static double out[BENCH_SAMPLES];
+    int kernelCount = sizeof(benchKernels) / sizeof(benchKernels[0]);
+    BenchResult results[sizeof(benchKernels) / sizeof(benchKernels[0])][BENCH_VARIANTS];
+    double roundMops[sizeof(benchKernels) / sizeof(benchKernels[0])][BENCH_VARIANTS][BENCH_ROUNDS];
+    FILE* baseline = baselineFile != NULL ? fopen(baselineFile, "r") : NULL;
+    int regressions = 0;
+
+    fillBenchData(&data);
+
+    /* Rounds are interleaved across the variants, so a slow spell of the machine
+       lands in one round of many variants rather than in every round of one */
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int k = 0; k < kernelCount; k++) {
+            for (int v = 0; v < BENCH_VARIANTS; v++) {
+                roundMops[k][v][round] = measureRound(&benchKernels[k], v, &data, out);
+            }
+        }
+    }
+
+    printf("%-10s %-8s %-12s %-12s %-12s %-12s %-10s %s\n", "Kernel", "Variant", "Mevals/s", "Max ULP", "Mean ULP",
+           "Rounded ULP", "Baseline", "Status");
+
+    for (int k = 0; k < kernelCount; k++) {
+        for (int v = 0; v < BENCH_VARIANTS; v++) {
+            char name[32], variant[32], line[256];
+            double baseMops = -1, baseUlp = 0;
+            const char* status = "new";
+
+            results[k][v] = measureKernel(&benchKernels[k], v, &data, out, roundMops[k][v]);
+            if (results[k][v].mops < 0) {
+                continue;
+            }
+
+            if (baseline != NULL) {
+                rewind(baseline);
+                while (fgets(line, sizeof(line), baseline) != NULL) {
+                    double mops, ulp;
+                    if (sscanf(line, "%31s %31s %lf %*g %lf", name, variant, &mops, &ulp) == 4 &&
+                        strcmp(name, benchKernels[k].name) == 0 && strcmp(variant, benchVariants[v]) == 0) {
+                        baseMops = mops;
+                        baseUlp = ulp;
+                    }
+                }
+            }
+            if (baseMops > 0) {
+                if (results[k][v].mops < (1 - BENCH_REGRESSION_TOLERANCE) * baseMops) {
+                    status = "SLOWER";
+                    regressions++;
+                } else if (results[k][v].roundedUlp > baseUlp) {
+                    status = "LESS ACCURATE";
+                    regressions++;
+                } else {
+                    status = "ok";
+                }
+            }
+
+            printf("%-10s %-8s %-12.2f %-12.2f %-12.4f %-12.2f ", benchKernels[k].name, benchVariants[v],
+                   results[k][v].mops, results[k][v].maxUlp, results[k][v].meanUlp, results[k][v].roundedUlp);
+            if (baseMops > 0) {
+                printf("%-10.2f %s\n", baseMops, status);
             } else {
-                break;
+                printf("%-10s %s\n", "-", status);
             }
         }
     }
-    return value;
+
+    if (baseline != NULL) {
+        fclose(baseline);
+    } else if (baselineFile != NULL) {
+        baseline = fopen(baselineFile, "w");
+        if (baseline == NULL) {
+            printf("Could not write the baseline to %s.\n", baselineFile);
+            return 1;
+        }
+        for (int k = 0; k < kernelCount; k++) {
+            for (int v = 0; v < BENCH_VARIANTS; v++) {
+                if (results[k][v].mops >= 0) {
+                    fprintf(baseline, "%s %s %.17g %.17g %.17g\n", benchKernels[k].name, benchVariants[v],
+                            results[k][v].mops, results[k][v].maxUlp, results[k][v].roundedUlp);
+                }
+            }
+        }
+        fclose(baseline);
+        printf("Baseline written to %s.\n", baselineFile);
+    }
+
+    if (regressions > 0) {
+        printf("%d kernel variant(s) regressed against the baseline.\n", regressions);
+        return 1;
+    }
+    return 0;
 }
 
-/* Function to ask if the user wants to perform another calculation */
-void continueOrExit() {
+/* Function to ask if the user wants to perform another calculation.
+   Returns 1 to return to the menu, or 0 to exit the program. */
+int continueOrExit() {
     char choice1;
     while (1) {
         printf("\nWould you like to perform another calculation? (y/n): ");
-        if (scanf(" %c", &choice1) == 1) {
-            if (choice1 == 'y' || choice1 == 'Y') {
-                printf("\nReturning to menu...\n");
-                menu();
-                break;
-            } else if (choice1 == 'n' || choice1 == 'N') {
-                printf("Exiting the program. Goodbye!\n");
-                exit(0);
-            } else {
-                printf("Invalid input. Please enter 'y' for yes or 'n' for no.\n");
-            }
+        if (scanf(" %c", &choice1) != 1) {
+            return 0;
+        }
+        if (choice1 == 'y' || choice1 == 'Y') {
+            return 1;
+        } else if (choice1 == 'n' || choice1 == 'N') {
+            printf("Exiting the program. Goodbye!\n");
+            return 0;
+        } else {
+            printf("Invalid input. Please enter 'y' for yes or 'n' for no.\n");
         }
     }
 }
 
-/* Main menu function */
-void menu() {
+/* Main menu function.
+   Performs one calculation and returns 1 to show the menu again, or 0 to exit. */
+int menu() {
     int choice;
     char ch;
     printf("1. Enter P, r, n, t. Find B.\n");
@@ -79,22 +2002,25 @@ void menu() {
     printf("5. Enter n, r, P, B. Find t.\n");
     printf("6. Generate report for given year interval.\n");
     printf("7. Compare two accounts.\n");
+    printf("8. Simulate balances under stochastic interest rates.\n");
+    printf("9. Enter P, r, n, t. Find B in exact cents.\n");
+    printf("10. Find r for accounts with irregular deposits (XIRR).\n");
     printf("0. Exit program.\n");
 
     while (1) {
-        printf("Enter your option (0-7): ");
+        printf("Enter your option (0-10): ");
         if (scanf("%d%c", &choice, &ch) == 2 && ch == '\n') {
-            if (choice >= 0 && choice <= 7) {
+            if (choice >= 0 && choice <= 10) {
                 if (choice == 0) {
                     printf("Exiting the program. Goodbye!\n");
-                    exit(0);
+                    return 0;
                 }
                 break;
             } else {
-                printf("Invalid input. Please enter an integer between 0 and 7.\n");
+                printf("Invalid input. Please enter an integer between 0 and 10.\n");
             }
         } else {
-            printf("Invalid input. Please enter an integer between 0 and 7, without any decimals.\n");
+            printf("Invalid input. Please enter an integer between 0 and 11, without any decimals.\n");
             while (getchar() != '\n');
         }
     }
@@ -109,9 +2035,8 @@ void menu() {
         n = getValidIntInput("Enter the compounding frequency per year (n): ");
         t = getValidInput("Enter the number of years of investment (t): ");
 
-        B = P * pow((1 + r / n), n * t);
+        B = findBalance(P, r, n, t);
         printf("The balance (B) is: %.2f\n", B);
-        continueOrExit();
 
     } else if (choice == 2) {
         double P, r, B, t;
@@ -123,9 +2048,8 @@ void menu() {
         t = getValidInput("Enter the number of years of investment (t): ");
         B = getValidInput("Enter the balance (B): ");
 
-        P = (B / pow((1 + r / n), n * t));
+        P = findPrincipal(r, n, t, B);
         printf("The Principal invested (P) is: %.2f\n", P);
-        continueOrExit();
 
     } else if (choice == 3) {
         double P, r, B, t;
@@ -137,13 +2061,12 @@ void menu() {
         P = getValidInput("Enter the principal invested (P): ");
         B = getValidInput("Enter the balance (B): ");
 
-        r = n * (exp(log(B / P) / (n * t)) - 1);
+        r = findRate(n, t, P, B);
         printf("The interest rate (r in decimal) is: %.3f\n", r);
-        continueOrExit();
 
     } else if (choice == 4) {
         double P, r, B, t;
-        int n = -1, i;
+        int n;
         printf("Option 4 has been selected: Find n.\n");
 
         t = getValidInput("Enter the number of years of investment (t): ");
@@ -151,20 +2074,12 @@ void menu() {
         P = getValidInput("Enter the principal invested (P): ");
         B = getValidInput("Enter the balance (B): ");
 
-        for (i = 1; i <= 12; i++) {
-            double j = P * pow((1 + r / i), (i * t));
-            if (fabs(j - B) < 0.01) {
-                n = i;
-                break;
-            }
-        }
-
+        n = findFrequency(t, r, P, B);
         if (n != -1) {
             printf("The compounding frequency per year (n) is: %d\n", n);
         } else {
             printf("No compounding frequency found that meets the balance criteria.\n");
         }
-        continueOrExit();
 
     } else if (choice == 5) {
         double P, r, B, t;
@@ -176,34 +2091,56 @@ void menu() {
         P = getValidInput("Enter the principal invested (P): ");
         B = getValidInput("Enter the balance (B): ");
 
-        t = log(B / P) / (n * log(1 + r / n));
+        t = findTime(n, r, P, B);
         printf("The time interval (t) is approximately: %.2f years.\n", t);
-        continueOrExit();
 
     } else if (choice == 6) {
-        double P, r, B;
-        int n, t1, t2;
+        ReportSpec spec;
+        int format;
         printf("Option 6 has been selected: Generate report for given year interval.\n");
 
-        P = getValidInput("Enter the principal invested (P): ");
-        r = getValidInput("Enter the interest rate (r in decimal): ");
-        n = getValidIntInput("Enter the compounding frequency per year (n): ");
-        t1 = getValidIntInput("Enter the start year (t1): ");
-        t2 = getValidIntInput("Enter the end year (t2): ");
+        spec.P = getValidInput("Enter the principal invested (P): ");
+        spec.r = getValidInput("Enter the interest rate (r in decimal): ");
+        spec.n = getValidIntInput("Enter the compounding frequency per year (n): ");
+        spec.t1 = getValidIntInput("Enter the start year (t1): ");
+        spec.t2 = getValidIntInput("Enter the end year (t2): ");
 
-        if (t2 < t1) {
+        while (spec.t2 < spec.t1) {
             printf("Invalid input for end year. Please ensure that the end year is greater than or equal to the start year.\n");
-            printf("Enter the end year (t2): ");
-            scanf("%d", &t2);
+            spec.t2 = getValidIntInput("Enter the end year (t2): ");
         }
-        printf("%-6s %-15s %-15s %-20s %-12s\n", "Year", "Principal", "Interest rate", "Compound ratio", "Balance");
+        spec.granularity = getValidChoice("Enter the report granularity (1 = yearly, 2 = monthly, 3 = per compounding period): ", 1, 3);
+        spec.deposit = getValidSignedInput("Enter the deposit added at the end of each step (negative for withdrawal, 0 for none): ");
+        spec.account = -1;
+        format = getValidChoice("Enter the output format (1 = screen, 2 = CSV file, 3 = binary file): ", 1, 3);
 
-        for (int t = t1; t <= t2; t++) {
-            B = P * pow((1 + r / n), n * t);
-            printf("%-6d %-15.2f %-15.3f %-20d %-12.2f\n", t, P, r, n, B);
-        }
+        if (format == REPORT_SCREEN) {
+            generateReport(&spec, stdout, format);
+        } else {
+            char filename[256];
+            FILE* out;
+            char* buffer;
 
-        continueOrExit();
+            printf("Enter the output file name: ");
+            scanf("%255s", filename);
+            out = fopen(filename, format == REPORT_CSV ? "w" : "wb");
+            if (out == NULL) {
+                printf("Could not open %s for writing.\n", filename);
+            } else {
+                long rows;
+                buffer = malloc(REPORT_BUFFER_SIZE);
+                if (buffer != NULL) {
+                    setvbuf(out, buffer, _IOFBF, REPORT_BUFFER_SIZE);
+                }
+                rows = generateReport(&spec, out, format);
+                if (fclose(out) != 0 || rows < 0) {
+                    printf("An error occurred while writing %s.\n", filename);
+                } else {
+                    printf("%ld rows written to %s.\n", rows, filename);
+                }
+                free(buffer);
+            }
+        }
 
     } else if (choice == 7) {
         double P, r, balance1, balance2;
@@ -247,6 +2184,183 @@ void menu() {
             }
         }
         printf("It would take approximately %d years and %d months for the balance in the second account to get as close as possible to the balance in the first account.\n", best_t2_years, best_t2_months);
-        continueOrExit();
+
+    } else if (choice == 8) {
+        static double history[SIM_MAX_HISTORY];
+        Simulation sim;
+        double t;
+        int threads;
+        long reached = 0;
+        struct timespec begin, finish;
+        printf("Option 8 has been selected: Simulate balances under stochastic interest rates.\n");
+
+        sim.P = getValidInput("Enter the principal invested (P): ");
+        sim.r0 = getValidInput("Enter the current interest rate (r in decimal): ");
+        sim.n = getValidIntInput("Enter the compounding frequency per year (n): ");
+        t = getValidInput("Enter the number of years of investment (t): ");
+        sim.target = getValidInput("Enter the target balance (B): ");
+        sim.model = getValidChoice("Enter the rate model (1 = Vasicek, 2 = CIR, 3 = historical bootstrap): ", 1, 3);
+        sim.a = 1;
+        sim.b = sim.r0;
+        sim.sigma = 0;
+        sim.history = history;
+        sim.historyCount = 0;
+
+        if (sim.model == MODEL_BOOTSTRAP) {
+            char filename[256];
+            while (sim.historyCount <= 0) {
+                printf("Enter the file of historical annual rates (in decimal): ");
+                scanf("%255s", filename);
+                sim.historyCount = loadRateHistory(filename, history, SIM_MAX_HISTORY);
+                if (sim.historyCount <= 0) {
+                    printf("Could not read any rates from %s.\n", filename);
+                }
+            }
+        } else {
+            sim.a = getValidInput("Enter the speed of mean reversion (a): ");
+            sim.b = getValidInput("Enter the long-term mean rate (b in decimal): ");
+            sim.sigma = getValidInput("Enter the rate volatility (sigma): ");
+        }
+        sim.paths = getValidIntInput("Enter the number of paths to simulate: ");
+        threads = getValidChoice("Enter the number of threads: ", 1, SIM_MAX_THREADS);
+        sim.seed = (uint64_t)getValidIntInput("Enter the random seed: ");
+        sim.steps = lround(sim.n * t);
+
+        sim.finals = malloc(sim.paths * sizeof(double));
+        sim.times = malloc(sim.paths * sizeof(double));
+        if (sim.finals == NULL || sim.times == NULL) {
+            printf("Not enough memory to simulate %ld paths.\n", sim.paths);
+        } else {
+            clock_gettime(CLOCK_MONOTONIC, &begin);
+            if (runSimulation(&sim, threads) != 0) {
+                printf("Some threads could not be started; the remaining threads completed the simulation.\n");
+            }
+            clock_gettime(CLOCK_MONOTONIC, &finish);
+
+            for (long i = 0; i < sim.paths; i++) {
+                if (sim.times[i] >= 0) {
+                    sim.times[reached++] = sim.times[i];
+                }
+            }
+            qsort(sim.finals, sim.paths, sizeof(double), compareDoubles);
+            qsort(sim.times, reached, sizeof(double), compareDoubles);
+
+            printf("Simulated %ld paths of %ld periods in %.3f seconds.\n", sim.paths, sim.steps,
+                   (finish.tv_sec - begin.tv_sec) + (finish.tv_nsec - begin.tv_nsec) / 1e9);
+            printf("%-12s %-15s %-20s\n", "Percentile", "Balance", "Years to target");
+            for (int q = 5; q <= 95; q += q == 5 || q == 75 ? 20 : 25) {
+                if (reached > 0) {
+                    printf("%-12d %-15.2f %-20.2f\n", q, percentile(sim.finals, sim.paths, q), percentile(sim.times, reached, q));
+                } else {
+                    printf("%-12d %-15.2f %-20s\n", q, percentile(sim.finals, sim.paths, q), "-");
+                }
+            }
+            printf("The target balance was reached within %.2f years on %.2f%% of the paths.\n", t, 100.0 * reached / sim.paths);
+        }
+        free(sim.finals);
+        free(sim.times);
+
+    } else if (choice == 9) {
+        double P, r, t, B;
+        int n;
+        long periods;
+        uint128 numerator, denominator, exactCents, ledgerCents;
+        printf("Option 9 has been selected: Find B in exact cents.\n");
+
+        P = getValidInput("Enter the principal invested (P): ");
+        r = getValidInput("Enter the interest rate (r in decimal): ");
+        n = getValidIntInput("Enter the compounding frequency per year (n): ");
+        t = getValidInput("Enter the number of years of investment (t): ");
+
+        if (!(n * t <= FIXED_MAX_PERIODS)) {
+            printf("n * t is too large for exact-cents arithmetic (at most %.0f periods).\n", FIXED_MAX_PERIODS);
+        } else if (!(r <= FIXED_MAX_RATE)) {
+            printf("The interest rate is too large for exact-cents arithmetic (at most %.0f).\n", FIXED_MAX_RATE);
+        } else if (!(P * 100 <= FIXED_MAX_CENTS)) {
+            printf("The principal is too large for exact-cents arithmetic (at most %.2f).\n", FIXED_MAX_CENTS / 100);
+        } else {
+            uint128 cents = (uint128)nearbyint(P * 100);
+
+            periods = lround(n * t);
+            if (fabs(n * t - periods) > 1e-9) {
+                printf("n * t is not a whole number of periods; using %ld periods.\n", periods);
+            }
+            B = P * pow((1 + r / n), (double)periods);
+            growthRatio(r, n, &numerator, &denominator);
+
+            if (exactCentsBalance(cents, numerator, denominator, periods, &exactCents) != 0) {
+                printf("The balance is too large for exact-cents arithmetic.\n");
+            } else {
+                unsigned long long exact = (unsigned long long)exactCents;
+                printf("The balance (B) with floating point is: %.2f\n", B);
+                printf("The balance (B) in exact cents is: %llu.%02llu (difference %+.2f)\n",
+                       exact / 100, exact % 100, exact / 100.0 - B);
+                if (periods > LEDGER_MAX_PERIODS) {
+                    printf("The balance rounded to the cent every period is only computed up to %d periods.\n",
+                           LEDGER_MAX_PERIODS);
+                } else if (ledgerCentsBalance(cents, numerator, denominator, periods, &ledgerCents) != 0) {
+                    printf("The balance rounded to the cent every period is too large for exact-cents arithmetic.\n");
+                } else {
+                    unsigned long long ledger = (unsigned long long)ledgerCents;
+                    printf("The balance (B) rounded to the cent every period is: %llu.%02llu (difference %+.2f)\n",
+                           ledger / 100, ledger % 100, ledger / 100.0 - B);
+                }
+            }
+        }
+
+    } else if (choice == 10) {
+        CashFlowBook book;
+        char filename[256];
+        int n, threads;
+        printf("Option 10 has been selected: Find r for accounts with irregular deposits (XIRR).\n");
+        printf("Each line of the input file is: account YYYY-MM-DD amount\n");
+        printf("Deposits are negative amounts; withdrawals and the final balance are positive.\n");
+
+        printf("Enter the cash-flow file name: ");
+        scanf("%255s", filename);
+        n = getValidIntInput("Enter the compounding frequency per year for the reported rate (n): ");
+        threads = getValidChoice("Enter the number of threads: ", 1, XIRR_MAX_THREADS);
+
+        if (loadCashFlows(filename, &book) != 0) {
+            printf("Could not read cash flows from %s.\n", filename);
+        } else {
+            struct timespec begin, finish;
+            long solved = 0, totalIterations = 0;
+            FILE* out;
+
+            clock_gettime(CLOCK_MONOTONIC, &begin);
+            atomic_store(&book.nextChunk, 0);
+            if (runWorkers(xirrWorker, &book, threads) != 0) {
+                printf("Could not start all threads; the remaining ones solved every account.\n");
+            }
+            clock_gettime(CLOCK_MONOTONIC, &finish);
+
+            printf("Enter the output file name: ");
+            scanf("%255s", filename);
+            out = fopen(filename, "w");
+            if (out == NULL) {
+                printf("Could not open %s for writing.\n", filename);
+            } else {
+                fprintf(out, "account,effective_rate,nominal_rate,iterations\n");
+                for (long a = 0; a < book.accountCount; a++) {
+                    if (isnan(book.rates[a])) {
+                        fprintf(out, "%s,,,%d\n", book.ids[a], book.iterations[a]);
+                    } else {
+                        double nominal = n * expm1(log1p(book.rates[a]) / n);
+                        fprintf(out, "%s,%.10f,%.10f,%d\n", book.ids[a], book.rates[a], nominal, book.iterations[a]);
+                        solved++;
+                        totalIterations += book.iterations[a];
+                    }
+                }
+                fclose(out);
+                printf("Solved %ld of %ld accounts (%ld cash flows) in %.3f seconds.\n", solved, book.accountCount,
+                       book.flowCount, (finish.tv_sec - begin.tv_sec) + (finish.tv_nsec - begin.tv_nsec) / 1e9);
+                printf("Average iterations per account: %.2f\n", solved > 0 ? (double)totalIterations / solved : 0.0);
+                printf("Results written to %s.\n", filename);
+            }
+            freeCashFlows(&book);
+        }
     }
+
+    return continueOrExit();
 }